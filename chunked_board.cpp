@@ -0,0 +1,308 @@
+#include <mpi.h>
+#include <algorithm>
+#include <cstring>
+#include <unordered_set>
+
+#include "chunked_board.hpp"
+#include "digest.hpp"
+
+const int RING_SIZE = 4 * CHUNK_SIZE;
+const int RECORD_SIZE = sizeof(uint64_t) + RING_SIZE;
+
+Chunk* ChunkPool::allocate()
+{
+    if (free_chunks.empty())
+    {
+        Chunk *block = new Chunk[CHUNK_BLOCK];
+        blocks.push_back(block);
+        for (int i = 0; i < CHUNK_BLOCK; i++)
+            free_chunks.push_back(&block[i]);
+    }
+
+    Chunk *chunk = free_chunks.back();
+    free_chunks.pop_back();
+    memset(chunk->cells, 0, sizeof(chunk->cells));
+    return chunk;
+}
+
+void ChunkPool::release(Chunk *chunk)
+{
+    free_chunks.push_back(chunk);
+}
+
+void ChunkPool::clean()
+{
+    for (Chunk *block : blocks)
+        delete [] block;
+    blocks.clear();
+    free_chunks.clear();
+}
+
+uint64_t ChunkedBoard::key(int chunk_x, int chunk_y)
+{
+    return ((uint64_t)(uint32_t)chunk_x << 32) | (uint32_t)chunk_y;
+}
+
+int ChunkedBoard::key_x(uint64_t key)
+{
+    return (int32_t)(uint32_t)(key >> 32);
+}
+
+int ChunkedBoard::key_y(uint64_t key)
+{
+    return (int32_t)(uint32_t)key;
+}
+
+int ChunkedBoard::floor_div(int value, int divisor)
+{
+    return value >= 0 ? value / divisor : -((-value + divisor - 1) / divisor);
+}
+
+uint64_t ChunkedBoard::morton(int chunk_x, int chunk_y)
+{
+    uint64_t code = 0;
+    uint32_t ux = (uint32_t)chunk_x ^ 0x80000000u, uy = (uint32_t)chunk_y ^ 0x80000000u;
+    for (int i = 0; i < 32; i++)
+    {
+        code |= (uint64_t)((ux >> i) & 1) << (2 * i);
+        code |= (uint64_t)((uy >> i) & 1) << (2 * i + 1);
+    }
+    return code;
+}
+
+int ChunkedBoard::owner(int chunk_x, int chunk_y)
+{
+    return (morton(chunk_x, chunk_y) >> (2 * OWNERSHIP_LEVEL)) % process_count;
+}
+
+Chunk* ChunkedBoard::find(int chunk_x, int chunk_y)
+{
+    uint64_t chunk_key = key(chunk_x, chunk_y);
+    auto found = chunks.find(chunk_key);
+    if (found != chunks.end())
+        return found->second;
+    found = ghosts.find(chunk_key);
+    if (found != ghosts.end())
+        return found->second;
+    return NULL;
+}
+
+ChunkedBoard::ChunkedBoard(PatternType initial_pattern, int initial_size, int rank, int process_count)
+{
+    this->rank = rank;
+    this->process_count = process_count;
+
+    bool (*condition)(int, int, int) = Segment::pattern_condition(initial_pattern);
+    if (condition == NULL)
+        return;
+
+    for (int global_y = 0; global_y < initial_size; global_y++)
+    {
+        int chunk_y = floor_div(global_y, CHUNK_SIZE);
+        for (int global_x = 0; global_x < initial_size; global_x++)
+        {
+            int chunk_x = floor_div(global_x, CHUNK_SIZE);
+            if (owner(chunk_x, chunk_y) != rank || !condition(global_x, global_y, initial_size))
+                continue;
+
+            Chunk *&chunk = chunks[key(chunk_x, chunk_y)];
+            if (chunk == NULL)
+                chunk = pool.allocate();
+            chunk->cells[global_y - chunk_y * CHUNK_SIZE][global_x - chunk_x * CHUNK_SIZE] = true;
+        }
+    }
+}
+
+void ChunkedBoard::pack_ring(Chunk *chunk, uint64_t chunk_key, vector<char> &buffer)
+{
+    size_t offset = buffer.size();
+    buffer.resize(offset + RECORD_SIZE);
+    char *record = buffer.data() + offset;
+
+    memcpy(record, &chunk_key, sizeof(uint64_t));
+    bool *ring = (bool*)(record + sizeof(uint64_t));
+    for (int i = 0; i < CHUNK_SIZE; i++)
+    {
+        ring[i] = chunk->cells[0][i];
+        ring[CHUNK_SIZE + i] = chunk->cells[CHUNK_SIZE - 1][i];
+        ring[2 * CHUNK_SIZE + i] = chunk->cells[i][0];
+        ring[3 * CHUNK_SIZE + i] = chunk->cells[i][CHUNK_SIZE - 1];
+    }
+}
+
+void ChunkedBoard::unpack_ring(const char *record)
+{
+    uint64_t chunk_key;
+    memcpy(&chunk_key, record, sizeof(uint64_t));
+    const bool *ring = (const bool*)(record + sizeof(uint64_t));
+
+    Chunk *ghost = pool.allocate();
+    for (int i = 0; i < CHUNK_SIZE; i++)
+    {
+        ghost->cells[0][i] = ring[i];
+        ghost->cells[CHUNK_SIZE - 1][i] = ring[CHUNK_SIZE + i];
+        ghost->cells[i][0] = ring[2 * CHUNK_SIZE + i];
+        ghost->cells[i][CHUNK_SIZE - 1] = ring[3 * CHUNK_SIZE + i];
+    }
+    ghosts[chunk_key] = ghost;
+}
+
+void ChunkedBoard::exchange_ghosts()
+{
+    vector<vector<char>> outgoing(process_count);
+    vector<int> targets;
+
+    for (auto &entry : chunks)
+    {
+        int chunk_x = key_x(entry.first), chunk_y = key_y(entry.first);
+        targets.clear();
+        for (int dy = -1; dy <= 1; dy++)
+        {
+            for (int dx = -1; dx <= 1; dx++)
+            {
+                int target = owner(chunk_x + dx, chunk_y + dy);
+                if (target != rank && std::find(targets.begin(), targets.end(), target) == targets.end())
+                    targets.push_back(target);
+            }
+        }
+        for (int target : targets)
+            pack_ring(entry.second, entry.first, outgoing[target]);
+    }
+
+    vector<int> send_counts(process_count), send_displs(process_count), recv_counts(process_count), recv_displs(process_count);
+    vector<char> send_buffer;
+    for (int i = 0; i < process_count; i++)
+    {
+        send_counts[i] = outgoing[i].size();
+        send_displs[i] = send_buffer.size();
+        send_buffer.insert(send_buffer.end(), outgoing[i].begin(), outgoing[i].end());
+    }
+
+    MPI_Alltoall(send_counts.data(), 1, MPI_INT, recv_counts.data(), 1, MPI_INT, MPI_COMM_WORLD);
+
+    int recv_size = 0;
+    for (int i = 0; i < process_count; i++)
+    {
+        recv_displs[i] = recv_size;
+        recv_size += recv_counts[i];
+    }
+    vector<char> recv_buffer(recv_size);
+
+    MPI_Alltoallv(send_buffer.data(), send_counts.data(), send_displs.data(), MPI_BYTE,
+                  recv_buffer.data(), recv_counts.data(), recv_displs.data(), MPI_BYTE, MPI_COMM_WORLD);
+
+    for (int offset = 0; offset < recv_size; offset += RECORD_SIZE)
+        unpack_ring(recv_buffer.data() + offset);
+}
+
+Chunk* ChunkedBoard::compute(int chunk_x, int chunk_y)
+{
+    bool area[CHUNK_SIZE + 2][CHUNK_SIZE + 2];
+    Chunk *neighbors[3][3];
+
+    for (int dy = -1; dy <= 1; dy++)
+        for (int dx = -1; dx <= 1; dx++)
+            neighbors[dy + 1][dx + 1] = find(chunk_x + dx, chunk_y + dy);
+
+    for (int i = 0; i < CHUNK_SIZE + 2; i++)
+    {
+        int local_y = i - 1, offset_y = local_y < 0 ? 0 : (local_y < CHUNK_SIZE ? 1 : 2);
+        for (int j = 0; j < CHUNK_SIZE + 2; j++)
+        {
+            int local_x = j - 1, offset_x = local_x < 0 ? 0 : (local_x < CHUNK_SIZE ? 1 : 2);
+            Chunk *source = neighbors[offset_y][offset_x];
+            area[i][j] = source != NULL && source->cells[(local_y + CHUNK_SIZE) % CHUNK_SIZE][(local_x + CHUNK_SIZE) % CHUNK_SIZE];
+        }
+    }
+
+    Chunk *next = pool.allocate();
+    bool alive = false;
+    for (int i = 1; i <= CHUNK_SIZE; i++)
+    {
+        for (int j = 1; j <= CHUNK_SIZE; j++)
+        {
+            int neighbors_count = area[i - 1][j - 1] + area[i - 1][j] + area[i - 1][j + 1]
+                                + area[i][j - 1] + area[i][j + 1]
+                                + area[i + 1][j - 1] + area[i + 1][j] + area[i + 1][j + 1];
+            bool cell = neighbors_count == 3 || (area[i][j] && neighbors_count == 2);
+            next->cells[i - 1][j - 1] = cell;
+            alive = alive || cell;
+        }
+    }
+
+    if (!alive)
+    {
+        pool.release(next);
+        return NULL;
+    }
+    return next;
+}
+
+void ChunkedBoard::iteration()
+{
+    exchange_ghosts();
+
+    unordered_set<uint64_t> candidates;
+    for (auto *source : {&chunks, &ghosts})
+    {
+        for (auto &entry : *source)
+        {
+            int chunk_x = key_x(entry.first), chunk_y = key_y(entry.first);
+            for (int dy = -1; dy <= 1; dy++)
+                for (int dx = -1; dx <= 1; dx++)
+                    if (owner(chunk_x + dx, chunk_y + dy) == rank)
+                        candidates.insert(key(chunk_x + dx, chunk_y + dy));
+        }
+    }
+
+    unordered_map<uint64_t, Chunk*> next_chunks;
+    for (uint64_t candidate : candidates)
+    {
+        Chunk *next = compute(key_x(candidate), key_y(candidate));
+        if (next != NULL)
+            next_chunks[candidate] = next;
+    }
+
+    for (auto &entry : chunks)
+        pool.release(entry.second);
+    for (auto &entry : ghosts)
+        pool.release(entry.second);
+    ghosts.clear();
+    chunks.swap(next_chunks);
+}
+
+long long ChunkedBoard::population()
+{
+    long long count = 0;
+    for (auto &entry : chunks)
+        for (int i = 0; i < CHUNK_SIZE; i++)
+            for (int j = 0; j < CHUNK_SIZE; j++)
+                count += entry.second->cells[i][j];
+    return count;
+}
+
+uint64_t ChunkedBoard::digest()
+{
+    uint64_t digest = 0;
+    for (auto &entry : chunks)
+    {
+        long long base_x = (long long)key_x(entry.first) * CHUNK_SIZE, base_y = (long long)key_y(entry.first) * CHUNK_SIZE;
+        for (int i = 0; i < CHUNK_SIZE; i++)
+            for (int j = 0; j < CHUNK_SIZE; j++)
+                if (entry.second->cells[i][j])
+                    digest += cell_hash(base_x + j, base_y + i, DIGEST_SEED);
+    }
+    return digest;
+}
+
+int ChunkedBoard::chunk_count()
+{
+    return chunks.size();
+}
+
+void ChunkedBoard::clean()
+{
+    chunks.clear();
+    ghosts.clear();
+    pool.clean();
+}
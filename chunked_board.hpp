@@ -0,0 +1,64 @@
+#ifndef CHUNKED_BOARD_HPP
+#define CHUNKED_BOARD_HPP
+
+#include <stdint.h>
+#include <unordered_map>
+#include <vector>
+
+#include "segment.hpp"
+
+using namespace std;
+
+const int CHUNK_SIZE = 32;
+const int CHUNK_BLOCK = 64;
+const int OWNERSHIP_LEVEL = 2;
+
+struct Chunk
+{
+    bool cells[CHUNK_SIZE][CHUNK_SIZE];
+};
+
+class ChunkPool
+{
+private:
+    vector<Chunk*> blocks;
+    vector<Chunk*> free_chunks;
+
+public:
+    Chunk* allocate();
+    void release(Chunk *chunk);
+    void clean();
+};
+
+class ChunkedBoard
+{
+private:
+    ChunkPool pool;
+    unordered_map<uint64_t, Chunk*> chunks;
+    unordered_map<uint64_t, Chunk*> ghosts;
+
+    static uint64_t key(int chunk_x, int chunk_y);
+    static int key_x(uint64_t key);
+    static int key_y(uint64_t key);
+    static int floor_div(int value, int divisor);
+    static uint64_t morton(int chunk_x, int chunk_y);
+    int owner(int chunk_x, int chunk_y);
+    Chunk* find(int chunk_x, int chunk_y);
+    void pack_ring(Chunk *chunk, uint64_t chunk_key, vector<char> &buffer);
+    void unpack_ring(const char *record);
+    void exchange_ghosts();
+    Chunk* compute(int chunk_x, int chunk_y);
+
+public:
+    int rank;
+    int process_count;
+
+    ChunkedBoard(PatternType initial_pattern, int initial_size, int rank, int process_count);
+    void iteration();
+    long long population();
+    uint64_t digest();
+    int chunk_count();
+    void clean();
+};
+
+#endif
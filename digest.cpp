@@ -0,0 +1,28 @@
+#include <mpi.h>
+#include <iomanip>
+#include <iostream>
+
+#include "digest.hpp"
+
+using namespace std;
+
+static uint64_t mix(uint64_t value)
+{
+    value += 0x9E3779B97F4A7C15ull;
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+    return value ^ (value >> 31);
+}
+
+uint64_t cell_hash(long long global_x, long long global_y, uint64_t seed)
+{
+    return mix(seed ^ mix(((uint64_t)(uint32_t)global_x << 32) | (uint32_t)global_y));
+}
+
+void report_digest(uint64_t local_digest, long long generation, int rank)
+{
+    unsigned long long digest, local = local_digest;
+    MPI_Reduce(&local, &digest, 1, MPI_UNSIGNED_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+    if (rank == 0)
+        cout << "generacja " << generation << ": " << hex << setw(16) << setfill('0') << digest << dec << setfill(' ') << endl;
+}
@@ -0,0 +1,12 @@
+#ifndef DIGEST_HPP
+#define DIGEST_HPP
+
+#include <stdint.h>
+
+const uint64_t DIGEST_SEED = 0;
+const uint64_t RANDOM_SEED = 1;
+
+uint64_t cell_hash(long long global_x, long long global_y, uint64_t seed);
+void report_digest(uint64_t local_digest, long long generation, int rank);
+
+#endif
@@ -0,0 +1,43 @@
+#!/bin/bash
+# ./digest_check.sh rozmiar iteracje wzorzec [co_ile_generacji]
+
+size=$1
+iterations=$2
+pattern=$3
+interval=${4:-1}
+MPIEXEC=${MPIEXEC:-mpiexec}
+RANKS_PARALLEL1=${RANKS_PARALLEL1:-"1 2 4"}
+RANKS_PARALLEL2=${RANKS_PARALLEL2:-"1 4"}
+
+digests()
+{
+    $MPIEXEC -n $2 ./$1 $size $iterations $pattern --digest $interval | grep '^generacja'
+}
+
+reference=$(digests game_of_life_serial.o 1)
+if [ -z "$reference" ]
+then
+    echo "game_of_life_serial.o: brak skrótów"
+    exit 1
+fi
+
+check()
+{
+    result=$(digests $1 $2)
+    divergence=$(paste -d ' ' <(echo "$reference") <(echo "$result") | awk 'NF != 6 || $3 != $6 { print $2; exit }')
+    if [ -n "$divergence" ]
+    then
+        echo "$1, $2 procesów: rozbieżność w generacji ${divergence%:}"
+        exit 1
+    fi
+    echo "$1, $2 procesów: zgodne"
+}
+
+for count in $RANKS_PARALLEL1
+do
+    check game_of_life_parallel1.o $count
+done
+for count in $RANKS_PARALLEL2
+do
+    check game_of_life_parallel2.o $count
+done
@@ -0,0 +1,133 @@
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+
+#include "ensemble.hpp"
+#include "digest.hpp"
+
+BoardBatch::BoardBatch(int size, long long iterations)
+{
+    this->size = size;
+    this->iterations = iterations;
+}
+
+int BoardBatch::index(int row, int column)
+{
+    return (row * (size + 2) + column) * LANES;
+}
+
+void BoardBatch::initialize_lane(int lane, const EnsembleJob &job)
+{
+    bool (*condition)(int, int, int) = Segment::pattern_condition(job.pattern);
+
+    for (int i = 0; i < size; i++)
+    {
+        for (int j = 0; j < size; j++)
+        {
+            bool alive = job.pattern == RANDOM ? (bool)(cell_hash(j, i, job.seed) & 1) : condition != NULL && condition(j, i, size);
+            cells[index(i + 1, j + 1) + lane] = alive;
+        }
+    }
+}
+
+void BoardBatch::initialize(const vector<EnsembleJob> &all_jobs)
+{
+    cells.assign((size + 2) * (size + 2) * LANES, 0);
+    next_cells.assign(cells.size(), 0);
+    for (int lane = 0; lane < (int)jobs.size(); lane++)
+        initialize_lane(lane, all_jobs[jobs[lane]]);
+}
+
+void BoardBatch::iteration()
+{
+    int row_stride = (size + 2) * LANES;
+    for (int i = 1; i <= size; i++)
+    {
+        for (int j = 1; j <= size; j++)
+        {
+            const uint8_t *center = &cells[index(i, j)];
+            uint8_t *next = &next_cells[index(i, j)];
+            for (int lane = 0; lane < LANES; lane++)
+            {
+                uint8_t neighbors = center[lane - row_stride - LANES] + center[lane - row_stride] + center[lane - row_stride + LANES]
+                                  + center[lane - LANES] + center[lane + LANES]
+                                  + center[lane + row_stride - LANES] + center[lane + row_stride] + center[lane + row_stride + LANES];
+                next[lane] = (neighbors == 3) | (center[lane] & (neighbors == 2));
+            }
+        }
+    }
+    cells.swap(next_cells);
+}
+
+void BoardBatch::run()
+{
+    for (long long i = 0; i < iterations; i++)
+        iteration();
+}
+
+long long BoardBatch::population(int lane)
+{
+    long long count = 0;
+    for (int i = 1; i <= size; i++)
+        for (int j = 1; j <= size; j++)
+            count += cells[index(i, j) + lane];
+    return count;
+}
+
+uint64_t BoardBatch::digest(int lane)
+{
+    uint64_t digest = 0;
+    for (int i = 1; i <= size; i++)
+        for (int j = 1; j <= size; j++)
+            if (cells[index(i, j) + lane])
+                digest += cell_hash(j - 1, i - 1, DIGEST_SEED);
+    return digest;
+}
+
+void BoardBatch::clean()
+{
+    vector<uint8_t>().swap(cells);
+    vector<uint8_t>().swap(next_cells);
+}
+
+vector<EnsembleJob> read_jobs(string filename)
+{
+    ifstream input(filename);
+    if (!input.is_open())
+        throw runtime_error("Nie można otworzyć pliku.");
+
+    vector<EnsembleJob> jobs;
+    EnsembleJob job;
+    int pattern_number;
+    while (input >> job.size >> job.iterations >> pattern_number >> job.seed)
+    {
+        if (job.size <= 0 || job.iterations < 0)
+            throw runtime_error("Niepoprawne zadanie.");
+        job.pattern = static_cast<PatternType>(pattern_number);
+        jobs.push_back(job);
+    }
+    return jobs;
+}
+
+vector<BoardBatch> create_batches(const vector<EnsembleJob> &jobs)
+{
+    vector<int> order(jobs.size());
+    for (int i = 0; i < (int)jobs.size(); i++)
+        order[i] = i;
+    stable_sort(order.begin(), order.end(), [&jobs](int a, int b)
+    {
+        if (jobs[a].size != jobs[b].size)
+            return jobs[a].size < jobs[b].size;
+        return jobs[a].iterations < jobs[b].iterations;
+    });
+
+    vector<BoardBatch> batches;
+    for (int job_index : order)
+    {
+        const EnsembleJob &job = jobs[job_index];
+        if (batches.empty() || batches.back().size != job.size || batches.back().iterations != job.iterations || batches.back().jobs.size() == LANES)
+            batches.push_back(BoardBatch(job.size, job.iterations));
+        batches.back().jobs.push_back(job_index);
+    }
+    return batches;
+}
@@ -0,0 +1,48 @@
+#ifndef ENSEMBLE_HPP
+#define ENSEMBLE_HPP
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "segment.hpp"
+
+using namespace std;
+
+const int LANES = 16;
+
+struct EnsembleJob
+{
+    int size;
+    long long iterations;
+    PatternType pattern;
+    unsigned int seed;
+};
+
+class BoardBatch
+{
+private:
+    vector<uint8_t> cells;
+    vector<uint8_t> next_cells;
+
+    int index(int row, int column);
+    void initialize_lane(int lane, const EnsembleJob &job);
+
+public:
+    int size;
+    long long iterations;
+    vector<int> jobs;
+
+    BoardBatch(int size, long long iterations);
+    void initialize(const vector<EnsembleJob> &all_jobs);
+    void iteration();
+    void run();
+    long long population(int lane);
+    uint64_t digest(int lane);
+    void clean();
+};
+
+vector<EnsembleJob> read_jobs(string filename);
+vector<BoardBatch> create_batches(const vector<EnsembleJob> &jobs);
+
+#endif
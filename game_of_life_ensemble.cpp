@@ -0,0 +1,81 @@
+#include <mpi.h>
+#include <iomanip>
+#include <iostream>
+
+#include "ensemble.hpp"
+
+using namespace std;
+
+long long next_batch(MPI_Win counter)
+{
+    long long one = 1, batch_index;
+    MPI_Fetch_and_op(&one, &batch_index, MPI_LONG_LONG, 0, 0, MPI_SUM, counter);
+    MPI_Win_flush(0, counter);
+    return batch_index;
+}
+
+int main(int argc, char *argv[])
+{
+    int process_count, rank, provided;
+    long double time;
+
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_SERIALIZED, &provided);
+    MPI_Comm_size(MPI_COMM_WORLD, &process_count);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+    vector<EnsembleJob> jobs = read_jobs(argv[1]);
+    vector<BoardBatch> batches = create_batches(jobs);
+    vector<long long> populations(jobs.size(), 0), all_populations(jobs.size(), 0);
+    vector<unsigned long long> digests(jobs.size(), 0), all_digests(jobs.size(), 0);
+
+    long long *counter_base;
+    MPI_Win counter;
+    MPI_Win_allocate(rank == 0 ? sizeof(long long) : 0, sizeof(long long), MPI_INFO_NULL, MPI_COMM_WORLD, &counter_base, &counter);
+    if (rank == 0)
+        *counter_base = 0;
+    MPI_Barrier(MPI_COMM_WORLD);
+    MPI_Win_lock_all(0, counter);
+
+    time = MPI_Wtime();
+    #pragma omp parallel
+    {
+        while (true)
+        {
+            long long batch_index;
+            #pragma omp critical
+            batch_index = next_batch(counter);
+            if (batch_index >= (long long)batches.size())
+                break;
+
+            BoardBatch &batch = batches[batch_index];
+            batch.initialize(jobs);
+            batch.run();
+            for (int lane = 0; lane < (int)batch.jobs.size(); lane++)
+            {
+                populations[batch.jobs[lane]] = batch.population(lane);
+                digests[batch.jobs[lane]] = batch.digest(lane);
+            }
+            batch.clean();
+        }
+    }
+    time = MPI_Wtime() - time;
+
+    MPI_Win_unlock_all(counter);
+    MPI_Win_free(&counter);
+
+    MPI_Reduce(populations.data(), all_populations.data(), jobs.size(), MPI_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+    MPI_Reduce(digests.data(), all_digests.data(), jobs.size(), MPI_UNSIGNED_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+    cout << "proces " << rank << ": " << time << "s" << endl;
+
+    if (rank == 0)
+    {
+        for (int i = 0; i < (int)jobs.size(); i++)
+            cout << "plansza " << i << ": rozmiar " << jobs[i].size << ", iteracje " << jobs[i].iterations
+                 << ", wzorzec " << jobs[i].pattern << ", ziarno " << jobs[i].seed
+                 << ", populacja " << all_populations[i]
+                 << ", skrot " << hex << setw(16) << setfill('0') << all_digests[i] << dec << setfill(' ') << endl;
+    }
+
+    MPI_Finalize();
+    return 0;
+}
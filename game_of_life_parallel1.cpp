@@ -3,10 +3,29 @@
 #include <cstring>
 
 #include "segment.hpp"
+#include "halo_exchange.hpp"
+#include "digest.hpp"
 
 using namespace std;
 
-void process(Segment segment, bool should_export, int frame_number, int rank, int process_count)
+void export_frame(BMPExporter &exporter, Segment &segment, int frame_number, int rank, int process_count)
+{
+    if (rank == process_count - 1)
+    {
+        exporter.change_size_info(segment.full_frame_size, segment.full_frame_size);
+        exporter.write("frames/frame" + to_string(frame_number) + ".bmp");
+    }
+    else
+    {
+        MPI_Recv(NULL, 0, MPI_C_BOOL, rank + 1, EXPORT_TAG, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+        exporter.append("frames/frame" + to_string(frame_number) + ".bmp");
+    }
+
+    if (rank > 0)
+        MPI_Send(NULL, 0, MPI_C_BOOL, rank - 1, EXPORT_TAG, MPI_COMM_WORLD);
+}
+
+void process(Segment segment, HaloExchange &halo, bool should_export, int frame_number, int rank, int process_count)
 {
     BMPExporter exporter = BMPExporter(segment.full_frame_size, segment.height, 4);
 
@@ -15,43 +34,10 @@ void process(Segment segment, bool should_export, int frame_number, int rank, in
     else
         segment.iteration();
 
-    bool *first_row = segment.frame[segment.overlap_up];
-    bool *prev_row = rank == 0 ? NULL : segment.frame[0];
-    bool *last_row = segment.frame[segment.full_height() - segment.overlap_down - 1];
-    bool *next_row = rank == process_count - 1 ? NULL : segment.frame[segment.full_height() - 1];
-
-    MPI_Status status;
-
-    if (rank == process_count - 1)
-    {
-        if (should_export)
-        {
-            exporter.change_size_info(segment.full_frame_size, segment.full_frame_size);
-            exporter.write("frames/frame" + to_string(frame_number) + ".bmp");
-        }
-
-	if (process_count > 1)
-	{
-            MPI_Send(first_row, segment.width, MPI_C_BOOL, rank - 1, 15, MPI_COMM_WORLD);
-            MPI_Recv(prev_row, segment.width, MPI_C_BOOL, rank - 1, 15, MPI_COMM_WORLD, &status);
-	}
-    }
-    else
-    {
-        if (process_count > 1)
-        {
-            MPI_Recv(next_row, segment.width, MPI_C_BOOL, rank + 1, 15, MPI_COMM_WORLD, &status);
-            MPI_Send(last_row, segment.width, MPI_C_BOOL, rank + 1, 15, MPI_COMM_WORLD);
-        }
-        if (should_export)
-            exporter.append("frames/frame" + to_string(frame_number) + ".bmp");
-
-        if (rank > 0 && process_count > 1)
-        {
-            MPI_Send(first_row, segment.width, MPI_C_BOOL, rank - 1, 15, MPI_COMM_WORLD);
-            MPI_Recv(prev_row, segment.width, MPI_C_BOOL, rank - 1, 15, MPI_COMM_WORLD, &status);
-        }
-    }
+    halo.start();
+    if (should_export)
+        export_frame(exporter, segment, frame_number, rank, process_count);
+    halo.wait();
 }
 
 int main(int argc, char *argv[])
@@ -59,9 +45,20 @@ int main(int argc, char *argv[])
     int full_frame_size = atoi(argv[1]), pattern_number = atoi(argv[3]), process_count, rank;
     long long iterations = atoll(argv[2]);
     long double time;
-    bool should_export = argc > 4 && strcmp(argv[4], "-e") == 0;
+    int digest_interval = 0;
+    bool should_export = false, shared_memory = false;
     PatternType pattern = static_cast<PatternType>(pattern_number);
 
+    for (int i = 4; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-e") == 0)
+            should_export = true;
+        else if (strcmp(argv[i], "-s") == 0)
+            shared_memory = true;
+        else if (strcmp(argv[i], "--digest") == 0 && i + 1 < argc)
+            digest_interval = atoi(argv[++i]);
+    }
+
     MPI_Init(&argc, &argv);
     MPI_Comm_size(MPI_COMM_WORLD, &process_count);
     MPI_Comm_rank(MPI_COMM_WORLD, &rank);
@@ -71,16 +68,37 @@ int main(int argc, char *argv[])
     int overlap_down = rank == process_count - 1 ? 0 : 1;
     int y = rank * height;
 
-    Segment segment(pattern, full_frame_size, full_frame_size, height, overlap_up, overlap_down, 0, 0, 0, y, rank);
+    SharedWindow *shared = shared_memory ? new SharedWindow((height + overlap_up + overlap_down) * full_frame_size) : NULL;
+    bool *storage = shared_memory ? shared->local_base() : NULL;
+    Segment segment(pattern, full_frame_size, full_frame_size, height, overlap_up, overlap_down, 0, 0, 0, y, rank, storage);
+
+    HaloExchange halo(shared);
+    if (rank > 0)
+        halo.add_row(segment.frame[segment.overlap_up], segment.frame[0], segment.width, rank - 1, ROW_TAG);
+    if (rank < process_count - 1)
+        halo.add_row(segment.frame[segment.full_height() - segment.overlap_down - 1], segment.frame[segment.full_height() - 1], segment.width, rank + 1, ROW_TAG);
+
+    if (digest_interval > 0)
+        report_digest(segment.digest(), 0, rank);
 
     time = MPI_Wtime();
     for (long long i = 0; i < iterations; i++)
-        process(segment, should_export, i, rank, process_count);
+    {
+        process(segment, halo, should_export, i, rank, process_count);
+        if (digest_interval > 0 && (i + 1) % digest_interval == 0)
+            report_digest(segment.digest(), i + 1, rank);
+    }
     time = MPI_Wtime() - time;
     time /= iterations;
     cout << "proces " << rank << ": " << time << "s" << endl;
 
+    halo.clean();
     segment.clean();
+    if (shared_memory)
+    {
+        shared->clean();
+        delete shared;
+    }
     MPI_Finalize();
     return 0;
 }
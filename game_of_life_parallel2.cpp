@@ -3,6 +3,8 @@
 #include <cstring>
 
 #include "segment.hpp"
+#include "halo_exchange.hpp"
+#include "digest.hpp"
 
 void export_segment(Segment segment, BMPExporter &exporter, bool *children_data, bool new_file, int frame_number, int rank)
 {
@@ -33,99 +35,51 @@ void export_segment(Segment segment, BMPExporter &exporter, bool *children_data,
         exporter.append("frames/frame" + to_string(frame_number) + ".bmp");
 }
 
-void process(Segment segment, bool should_export, int frame_number, int block_x, int block_y, int k, int base_size)
+void export_frame(Segment &segment, int frame_number, int block_x, int block_y, int k)
 {
-    BMPExporter exporter = BMPExporter(segment.full_frame_size, segment.height, 4);
-
-    bool *first_row = segment.frame[segment.overlap_up];
-    bool *prev_row = block_y == 0 ? NULL : segment.frame[0];
-    bool *last_row = segment.frame[segment.full_height() - segment.overlap_down - 1];
-    bool *next_row = block_y == k - 1 ? NULL : segment.frame[segment.full_height() - 1];
-
-    bool *first_col = block_x == 0 ? NULL : new bool[segment.height];
-    bool *next_col = block_x == k - 1 ? NULL : new bool[segment.height];
-
-    MPI_Status status;
     int rank = block_y * k + block_x;
-    int children_data_size, current_data_size;
-    bool *children_data, *current_data;
+    int children_data_size = segment.x * segment.height;
+    bool *children_data = new bool[children_data_size];
 
     if (block_x > 0)
-    {
-        children_data_size = segment.x * segment.height;
-        current_data_size = children_data_size + segment.width * segment.height;
-        children_data = new bool[children_data_size];
-
-        MPI_Recv(children_data, children_data_size, MPI_C_BOOL, rank - 1, 15, MPI_COMM_WORLD, &status);
-
-        for (int i = 0; i < segment.height; i++)
-        {
-            segment.frame[i + segment.overlap_up][0] = children_data[(i + 1) * segment.x - 1];
-            first_col[i] = segment.frame[i + segment.overlap_up][segment.overlap_left];
-        }
-        MPI_Send(first_col, segment.height, MPI_C_BOOL, rank - 1, 16, MPI_COMM_WORLD);
-        delete [] first_col;
-    }
-    else
-    {
-        children_data_size = 0;
-        current_data_size = base_size * segment.height;
-        children_data = new bool[current_data_size];
-    }
+        MPI_Recv(children_data, children_data_size, MPI_C_BOOL, rank - 1, EXPORT_TAG, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
 
     if (block_x < k - 1)
     {
-        current_data = new bool[current_data_size];
+        int current_width = segment.x + segment.width;
+        bool *current_data = new bool[current_width * segment.height];
         for (int i = 0; i < segment.height; i++)
         {
             for (int j = 0; j < segment.x; j++)
-                current_data[i * (segment.x + base_size) + j] = children_data[i * segment.x + j];
+                current_data[i * current_width + j] = children_data[i * segment.x + j];
             for (int j = 0; j < segment.width; j++)
-                current_data[i * (segment.x + base_size) + j + segment.x] = segment.frame[i + segment.overlap_up][j + segment.overlap_left];
+                current_data[i * current_width + j + segment.x] = segment.frame[i + segment.overlap_up][j + segment.overlap_left];
         }
 
-        MPI_Send(current_data, current_data_size, MPI_C_BOOL, rank + 1, 15, MPI_COMM_WORLD);
-        MPI_Recv(next_col, segment.height, MPI_C_BOOL, rank + 1, 16, MPI_COMM_WORLD, &status);
-
-        for (int i = 0; i < segment.height; i++)
-            segment.frame[i + segment.overlap_up][segment.full_width() - 1] = next_col[i];
-
-        delete [] children_data;
+        MPI_Send(current_data, current_width * segment.height, MPI_C_BOOL, rank + 1, EXPORT_TAG, MPI_COMM_WORLD);
         delete [] current_data;
-        delete [] next_col;
-    }
-
-    if (block_y == k - 1)
-    {
-        int target_rank = (block_y - 1) * k + block_x;
-        if (block_x == k - 1)
-        {
-            if (should_export)
-                export_segment(segment, exporter, children_data, true, frame_number, rank);
-            delete [] children_data;
-        }
-        MPI_Send(first_row, segment.full_width(), MPI_C_BOOL, target_rank, 17, MPI_COMM_WORLD);
-        MPI_Recv(prev_row, segment.full_width(), MPI_C_BOOL, target_rank, 17, MPI_COMM_WORLD, &status);
     }
     else
     {
-        int target_rank = (block_y + 1) * k + block_x;
-        MPI_Recv(next_row, segment.full_width(), MPI_C_BOOL, target_rank, 17, MPI_COMM_WORLD, &status);
-        MPI_Send(last_row, segment.full_width(), MPI_C_BOOL, target_rank, 17, MPI_COMM_WORLD);
+        BMPExporter exporter = BMPExporter(segment.full_frame_size, segment.height, 4);
 
-        if (block_x == k - 1)
-        {
-            if (should_export)
-                export_segment(segment, exporter, children_data, false, frame_number, rank);
-            delete [] children_data;
-        }
+        if (block_y < k - 1)
+            MPI_Recv(NULL, 0, MPI_C_BOOL, rank + k, EXPORT_TAG, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+        export_segment(segment, exporter, children_data, block_y == k - 1, frame_number, rank);
         if (block_y > 0)
-        {
-            int target_rank = (block_y - 1) * k + block_x;
-            MPI_Send(first_row, segment.full_width(), MPI_C_BOOL, target_rank, 17, MPI_COMM_WORLD);
-            MPI_Recv(prev_row, segment.full_width(), MPI_C_BOOL, target_rank, 17, MPI_COMM_WORLD, &status);
-        }
+            MPI_Send(NULL, 0, MPI_C_BOOL, rank - k, EXPORT_TAG, MPI_COMM_WORLD);
     }
+    delete [] children_data;
+}
+
+void process(Segment segment, HaloExchange &columns, HaloExchange &rows, bool should_export, int frame_number, int block_x, int block_y, int k)
+{
+    columns.start();
+    if (should_export)
+        export_frame(segment, frame_number, block_x, block_y, k);
+    columns.wait();
+
+    rows.exchange();
     segment.iteration();
 }
 
@@ -134,9 +88,20 @@ int main(int argc, char *argv[])
     int full_frame_size = atoi(argv[1]), pattern_number = atoi(argv[3]), process_count, rank;
     long long iterations = atoll(argv[2]);
     long double time;
-    bool should_export = argc > 4 && strcmp(argv[4], "-e") == 0;
+    int digest_interval = 0;
+    bool should_export = false, shared_memory = false;
     PatternType pattern = static_cast<PatternType>(pattern_number);
 
+    for (int i = 4; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-e") == 0)
+            should_export = true;
+        else if (strcmp(argv[i], "-s") == 0)
+            shared_memory = true;
+        else if (strcmp(argv[i], "--digest") == 0 && i + 1 < argc)
+            digest_interval = atoi(argv[++i]);
+    }
+
     MPI_Init(&argc, &argv);
     MPI_Comm_size(MPI_COMM_WORLD, &process_count);
     MPI_Comm_rank(MPI_COMM_WORLD, &rank);
@@ -161,16 +126,42 @@ int main(int argc, char *argv[])
             height = base_size * k - full_frame_size + 1;
     }
 
-    Segment segment(pattern, full_frame_size, width, height, overlap_up, overlap_down, overlap_left, overlap_right, x, y, rank);
+    SharedWindow *shared = shared_memory ? new SharedWindow((height + overlap_up + overlap_down) * (width + overlap_left + overlap_right)) : NULL;
+    bool *storage = shared_memory ? shared->local_base() : NULL;
+    Segment segment(pattern, full_frame_size, width, height, overlap_up, overlap_down, overlap_left, overlap_right, x, y, rank, storage);
+
+    HaloExchange columns(shared), rows(shared);
+    if (block_x > 0)
+        columns.add_column(segment, segment.overlap_left, 0, rank - 1, COLUMN_TAG);
+    if (block_x < k - 1)
+        columns.add_column(segment, segment.full_width() - segment.overlap_right - 1, segment.full_width() - 1, rank + 1, COLUMN_TAG);
+    if (block_y > 0)
+        rows.add_row(segment.frame[segment.overlap_up], segment.frame[0], segment.full_width(), rank - k, ROW_TAG);
+    if (block_y < k - 1)
+        rows.add_row(segment.frame[segment.full_height() - segment.overlap_down - 1], segment.frame[segment.full_height() - 1], segment.full_width(), rank + k, ROW_TAG);
+
+    if (digest_interval > 0)
+        report_digest(segment.digest(), 0, rank);
 
     time = MPI_Wtime();
     for (int i = 0; i < iterations; i++)
-        process(segment, should_export, i, block_x, block_y, k, base_size);
+    {
+        process(segment, columns, rows, should_export, i, block_x, block_y, k);
+        if (digest_interval > 0 && (i + 1) % digest_interval == 0)
+            report_digest(segment.digest(), i + 1, rank);
+    }
     time = MPI_Wtime() - time;
     time /= iterations;
     cout<< "proces " << rank << ": " << time << "s" << endl;
 
+    columns.clean();
+    rows.clean();
     segment.clean();
+    if (shared_memory)
+    {
+        shared->clean();
+        delete shared;
+    }
     MPI_Finalize();
     return 0;
 }
@@ -2,19 +2,33 @@
 #include <cstring>
 
 #include "segment.hpp"
+#include "digest.hpp"
 
 int main(int argc, char *argv[])
 {
     int full_frame_size = atoi(argv[1]), pattern_number = atoi(argv[3]);
     long long iterations = atoll(argv[2]);
     long double time;
-    bool should_export = argc > 4 && strcmp(argv[4], "-e") == 0;
+    int digest_interval = 0;
+    bool should_export = false;
     PatternType pattern = static_cast<PatternType>(pattern_number);
+
+    for (int i = 4; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-e") == 0)
+            should_export = true;
+        else if (strcmp(argv[i], "--digest") == 0 && i + 1 < argc)
+            digest_interval = atoi(argv[++i]);
+    }
+
     BMPExporter exporter(full_frame_size, full_frame_size, 4);
     Segment segment(pattern, full_frame_size, full_frame_size, full_frame_size, 0, 0, 0, 0, 0, 0, 0);
 
     MPI_Init(&argc, &argv);
 
+    if (digest_interval > 0)
+        report_digest(segment.digest(), 0, 0);
+
     time = MPI_Wtime();
     for (long long i = 0; i < iterations; i++)
     {
@@ -25,6 +39,9 @@ int main(int argc, char *argv[])
         }
         else
             segment.iteration();
+
+        if (digest_interval > 0 && (i + 1) % digest_interval == 0)
+            report_digest(segment.digest(), i + 1, 0);
     }
     time = MPI_Wtime() - time;
     time /= iterations;
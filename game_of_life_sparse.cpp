@@ -0,0 +1,49 @@
+#include <mpi.h>
+#include <iostream>
+#include <cstring>
+
+#include "chunked_board.hpp"
+#include "digest.hpp"
+
+using namespace std;
+
+int main(int argc, char *argv[])
+{
+    int initial_size = atoi(argv[1]), pattern_number = atoi(argv[3]), process_count, rank, digest_interval = 0;
+    long long iterations = atoll(argv[2]);
+    long double time;
+    PatternType pattern = static_cast<PatternType>(pattern_number);
+
+    for (int i = 4; i < argc; i++)
+        if (strcmp(argv[i], "--digest") == 0 && i + 1 < argc)
+            digest_interval = atoi(argv[++i]);
+
+    MPI_Init(&argc, &argv);
+    MPI_Comm_size(MPI_COMM_WORLD, &process_count);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+    ChunkedBoard board(pattern, initial_size, rank, process_count);
+
+    if (digest_interval > 0)
+        report_digest(board.digest(), 0, rank);
+
+    time = MPI_Wtime();
+    for (long long i = 0; i < iterations; i++)
+    {
+        board.iteration();
+        if (digest_interval > 0 && (i + 1) % digest_interval == 0)
+            report_digest(board.digest(), i + 1, rank);
+    }
+    time = MPI_Wtime() - time;
+    time /= iterations;
+    cout << "proces " << rank << ": " << time << "s, fragmenty: " << board.chunk_count() << endl;
+
+    long long population = board.population(), total_population;
+    MPI_Reduce(&population, &total_population, 1, MPI_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+    if (rank == 0)
+        cout << "populacja: " << total_population << endl;
+
+    board.clean();
+    MPI_Finalize();
+    return 0;
+}
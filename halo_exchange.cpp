@@ -0,0 +1,152 @@
+#include "halo_exchange.hpp"
+
+SharedWindow::SharedWindow(int size)
+{
+    MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &node_comm);
+    MPI_Comm_group(MPI_COMM_WORLD, &world_group);
+    MPI_Comm_group(node_comm, &node_group);
+    MPI_Win_allocate_shared(size, sizeof(bool), MPI_INFO_NULL, node_comm, &base, &window);
+    MPI_Win_lock_all(MPI_MODE_NOCHECK, window);
+}
+
+bool* SharedWindow::local_base()
+{
+    return base;
+}
+
+bool* SharedWindow::neighbor_base(int neighbor)
+{
+    int node_rank, disp_unit;
+    MPI_Aint size;
+    bool *neighbor_base;
+
+    MPI_Group_translate_ranks(world_group, 1, &neighbor, node_group, &node_rank);
+    if (node_rank == MPI_UNDEFINED)
+        return NULL;
+
+    MPI_Win_shared_query(window, node_rank, &size, &disp_unit, &neighbor_base);
+    return neighbor_base;
+}
+
+void SharedWindow::synchronize()
+{
+    MPI_Win_sync(window);
+    MPI_Barrier(node_comm);
+    MPI_Win_sync(window);
+}
+
+void SharedWindow::clean()
+{
+    MPI_Win_unlock_all(window);
+    MPI_Win_free(&window);
+    MPI_Group_free(&node_group);
+    MPI_Group_free(&world_group);
+    MPI_Comm_free(&node_comm);
+}
+
+HaloExchange::HaloExchange(SharedWindow *shared)
+{
+    this->shared = shared;
+}
+
+MPI_Datatype HaloExchange::column_type(Segment &segment, int column)
+{
+    vector<MPI_Aint> displacements(segment.height);
+    for (int i = 0; i < segment.height; i++)
+        MPI_Get_address(&segment.frame[i + segment.overlap_up][column], &displacements[i]);
+
+    MPI_Datatype type;
+    MPI_Type_create_hindexed_block(segment.height, 1, displacements.data(), MPI_C_BOOL, &type);
+    MPI_Type_commit(&type);
+    types.push_back(type);
+    return type;
+}
+
+bool* HaloExchange::shared_source(bool *send_start, int send_stride, int neighbor, int tag, int &source_stride)
+{
+    if (shared == NULL)
+        return NULL;
+
+    bool *neighbor_base = shared->neighbor_base(neighbor);
+    if (neighbor_base == NULL)
+        return NULL;
+
+    long long layout[2] = {send_start - shared->local_base(), send_stride};
+    long long neighbor_layout[2];
+    MPI_Sendrecv(layout, 2, MPI_LONG_LONG, neighbor, tag, neighbor_layout, 2, MPI_LONG_LONG, neighbor, tag, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+
+    source_stride = neighbor_layout[1];
+    return neighbor_base + neighbor_layout[0];
+}
+
+void HaloExchange::add_row(bool *send_row, bool *recv_row, int count, int neighbor, int tag)
+{
+    int source_stride;
+    bool *source = shared_source(send_row, 1, neighbor, tag, source_stride);
+    if (source != NULL)
+    {
+        copies.push_back({source, recv_row, count, source_stride, 1});
+        return;
+    }
+
+    MPI_Request send_request, recv_request;
+    MPI_Recv_init(recv_row, count, MPI_C_BOOL, neighbor, tag, MPI_COMM_WORLD, &recv_request);
+    MPI_Send_init(send_row, count, MPI_C_BOOL, neighbor, tag, MPI_COMM_WORLD, &send_request);
+    requests.push_back(recv_request);
+    requests.push_back(send_request);
+}
+
+void HaloExchange::add_column(Segment &segment, int send_column, int recv_column, int neighbor, int tag)
+{
+    int source_stride;
+    bool *source = shared_source(&segment.frame[segment.overlap_up][send_column], segment.full_width(), neighbor, tag, source_stride);
+    if (source != NULL)
+    {
+        copies.push_back({source, &segment.frame[segment.overlap_up][recv_column], segment.height, source_stride, segment.full_width()});
+        return;
+    }
+
+    MPI_Request send_request, recv_request;
+    MPI_Recv_init(MPI_BOTTOM, 1, column_type(segment, recv_column), neighbor, tag, MPI_COMM_WORLD, &recv_request);
+    MPI_Send_init(MPI_BOTTOM, 1, column_type(segment, send_column), neighbor, tag, MPI_COMM_WORLD, &send_request);
+    requests.push_back(recv_request);
+    requests.push_back(send_request);
+}
+
+void HaloExchange::start()
+{
+    if (!requests.empty())
+        MPI_Startall(requests.size(), requests.data());
+}
+
+void HaloExchange::wait()
+{
+    if (shared != NULL)
+    {
+        shared->synchronize();
+        for (HaloCopy &copy : copies)
+            for (int i = 0; i < copy.count; i++)
+                copy.destination[i * copy.destination_stride] = copy.source[i * copy.source_stride];
+        shared->synchronize();
+    }
+
+    if (!requests.empty())
+        MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+}
+
+void HaloExchange::exchange()
+{
+    start();
+    wait();
+}
+
+void HaloExchange::clean()
+{
+    for (MPI_Request &request : requests)
+        MPI_Request_free(&request);
+    for (MPI_Datatype &type : types)
+        MPI_Type_free(&type);
+    requests.clear();
+    types.clear();
+    copies.clear();
+}
@@ -0,0 +1,65 @@
+#ifndef HALO_EXCHANGE_HPP
+#define HALO_EXCHANGE_HPP
+
+#include <mpi.h>
+#include <vector>
+
+#include "segment.hpp"
+
+using namespace std;
+
+enum HaloTag
+{
+    ROW_TAG = 15,
+    COLUMN_TAG = 16,
+    EXPORT_TAG = 17
+};
+
+class SharedWindow
+{
+private:
+    MPI_Comm node_comm;
+    MPI_Group world_group;
+    MPI_Group node_group;
+    MPI_Win window;
+    bool *base;
+
+public:
+    SharedWindow(int size);
+    bool* local_base();
+    bool* neighbor_base(int neighbor);
+    void synchronize();
+    void clean();
+};
+
+struct HaloCopy
+{
+    bool *source;
+    bool *destination;
+    int count;
+    int source_stride;
+    int destination_stride;
+};
+
+class HaloExchange
+{
+private:
+    vector<MPI_Request> requests;
+    vector<MPI_Datatype> types;
+    vector<HaloCopy> copies;
+    SharedWindow *shared;
+
+    MPI_Datatype column_type(Segment &segment, int column);
+    bool* shared_source(bool *send_start, int send_stride, int neighbor, int tag, int &source_stride);
+
+public:
+    HaloExchange(SharedWindow *shared = NULL);
+    void add_row(bool *send_row, bool *recv_row, int count, int neighbor, int tag);
+    void add_column(Segment &segment, int send_column, int recv_column, int neighbor, int tag);
+    void start();
+    void wait();
+    void exchange();
+    void clean();
+};
+
+#endif
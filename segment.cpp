@@ -1,13 +1,11 @@
-#include <random>
-#include <functional>
-
 #include "segment.hpp"
+#include "digest.hpp"
 
-bool** Segment::create_empty_frame()
+bool** Segment::create_empty_frame(bool *storage)
 {
     bool **new_frame = new bool*[full_height()];
     for (int i = 0; i < full_height(); i++)
-        new_frame[i] = new bool[full_width()];
+        new_frame[i] = storage == NULL ? new bool[full_width()] : storage + i * full_width();
     return new_frame;
 }
 
@@ -28,8 +26,31 @@ bool Segment::O_condition(int global_x, int global_y, int full_frame_size)
 
 bool Segment::random_condition(int global_x, int global_y, int full_frame_size)
 {
-    static auto generator = bind(uniform_int_distribution<>(0, 1), default_random_engine());
-    return generator();
+    return cell_hash(global_x, global_y, RANDOM_SEED) & 1;
+}
+
+bool Segment::glider_condition(int global_x, int global_y, int full_frame_size)
+{
+    return (global_x == 1 && global_y == 0) || (global_x == 2 && global_y == 1) || (global_y == 2 && global_x >= 0 && global_x <= 2);
+}
+
+bool (*Segment::pattern_condition(PatternType pattern))(int, int, int)
+{
+    switch (pattern)
+    {
+    case T:
+        return T_condition;
+    case E:
+        return E_condition;
+    case O:
+        return O_condition;
+    case RANDOM:
+        return random_condition;
+    case GLIDER:
+        return glider_condition;
+    default:
+        return NULL;
+    }
 }
 
 void Segment::save_frame()
@@ -39,7 +60,7 @@ void Segment::save_frame()
             prev_frame[i][j] = frame[i][j];
 }
 
-Segment::Segment(PatternType initial_pattern, int full_frame_size, int width, int height, int overlap_up, int overlap_down, int overlap_left, int overlap_right, int x, int y, int rank)
+Segment::Segment(PatternType initial_pattern, int full_frame_size, int width, int height, int overlap_up, int overlap_down, int overlap_left, int overlap_right, int x, int y, int rank, bool *storage)
 {
     this->full_frame_size = full_frame_size;
     this->width = width;
@@ -51,9 +72,10 @@ Segment::Segment(PatternType initial_pattern, int full_frame_size, int width, in
     this->x = x;
     this->y = y;
     this->rank = rank;
+    this->storage = storage;
 
     this->frame = initialize_frame(initial_pattern);
-    this->prev_frame = create_empty_frame();
+    this->prev_frame = create_empty_frame(NULL);
 }
 
 int Segment::full_width()
@@ -98,6 +120,16 @@ string Segment::convert_to_string()
     return s;
 }
 
+uint64_t Segment::digest()
+{
+    uint64_t digest = 0;
+    for (int i = overlap_up; i < full_height() - overlap_down; i++)
+        for (int j = overlap_left; j < full_width() - overlap_right; j++)
+            if (frame[i][j])
+                digest += cell_hash(j - overlap_left + x, i - overlap_up + y, DIGEST_SEED);
+    return digest;
+}
+
 void Segment::export_full_frame(BMPExporter &exporter, int frame_number)
 {
     for (int i = 0; i < full_frame_size; i++)
@@ -115,26 +147,11 @@ void Segment::export_full_frame(BMPExporter &exporter, int frame_number)
 
 bool** Segment::initialize_frame(PatternType pattern)
 {
-    bool (*condition)(int, int, int);
-    switch (pattern)
-    {
-    case T:
-        condition = T_condition;
-        break;
-    case E:
-        condition = E_condition;
-        break;
-    case O:
-        condition = O_condition;
-        break;
-    case RANDOM:
-        condition = random_condition;
-        break;
-    default:
+    bool (*condition)(int, int, int) = pattern_condition(pattern);
+    if (condition == NULL)
         return NULL;
-    }
 
-    bool **new_frame = create_empty_frame();
+    bool **new_frame = create_empty_frame(storage);
     int global_x, global_y;
 
     for (int i = 0; i < full_height(); i++)
@@ -156,7 +173,8 @@ void Segment::clean()
 {
     for (int i = 0; i < full_height(); i++)
     {
-        delete [] frame[i];
+        if (storage == NULL)
+            delete [] frame[i];
         delete [] prev_frame[i];
     }
     delete [] frame;
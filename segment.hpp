@@ -1,3 +1,6 @@
+#ifndef SEGMENT_HPP
+#define SEGMENT_HPP
+
 #include <iostream>
 
 #include "image_export.hpp"
@@ -9,20 +12,23 @@ enum PatternType
     T,
     E,
     O,
-    RANDOM
+    RANDOM,
+    GLIDER
 };
 
 class Segment
 {
 private:
     bool **prev_frame;
+    bool *storage;
 
-    bool** create_empty_frame();
+    bool** create_empty_frame(bool *storage);
     bool** initialize_frame(PatternType pattern);
     static bool T_condition(int global_x, int global_y, int full_frame_size);
     static bool E_condition(int global_x, int global_y, int full_frame_size);
     static bool O_condition(int global_x, int global_y, int full_frame_size);
     static bool random_condition(int global_x, int global_y, int full_frame_size);
+    static bool glider_condition(int global_x, int global_y, int full_frame_size);
     void save_frame();
     int count_neighbors(int x, int y);
 
@@ -39,7 +45,8 @@ public:
     int y;
     int rank;
 
-    Segment(PatternType initial_pattern, int full_frame_size, int width, int height, int overlap_up, int overlap_down, int overlap_left, int overlap_right, int x, int y, int rank);
+    static bool (*pattern_condition(PatternType pattern))(int, int, int);
+    Segment(PatternType initial_pattern, int full_frame_size, int width, int height, int overlap_up, int overlap_down, int overlap_left, int overlap_right, int x, int y, int rank, bool *storage = NULL);
     int full_width();
     int full_height();
     void print_full_frame();
@@ -48,4 +55,7 @@ public:
     void iteration(BMPExporter &exporter);
     void iteration();
     string convert_to_string();
+    uint64_t digest();
 };
+
+#endif